@@ -99,6 +99,9 @@ private:
 	/// @return latency of the write operation
 	uint32_t _write(uint32_t address);
 
+	/// @brief Lets the differential fuzzer issue single accesses
+	friend struct EngineProbe;
+
 public:
 	Cache(uint32_t block_size,
 	      uint32_t associativity,
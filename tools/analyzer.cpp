@@ -0,0 +1,287 @@
+#include "analyzer.h"
+#include "cache.h"
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+namespace CACHE{
+
+void append_1024(std::vector<Access> &trace, uint32_t base_addr, uint32_t stride, bool write) {
+	for (uint32_t i = 0u; i < 1024u; i++) {
+		Access access;
+		access.kind = write ? Access::WRITE : Access::READ;
+		access.address = base_addr + i * stride; // wraps exactly like Cache::read_1024
+		trace.push_back(access);
+	}
+}
+
+// ReuseProfile
+
+uint64_t ReuseProfile::read_hits(uint32_t associativity) const {
+	uint64_t hits = 0u;
+	for (uint32_t d = 0u; d < associativity && d < read_histogram.size(); d++) {
+		hits += read_histogram[d];
+	}
+	return hits;
+}
+
+uint64_t ReuseProfile::write_hits(uint32_t associativity) const {
+	uint64_t hits = 0u;
+	for (uint32_t d = 0u; d < associativity && d < write_histogram.size(); d++) {
+		hits += write_histogram[d];
+	}
+	return hits;
+}
+
+double ReuseProfile::miss_ratio(uint32_t associativity) const {
+	uint64_t accesses = read_cold + write_cold;
+	for (size_t d = 0u; d < read_histogram.size(); d++) {
+		accesses += read_histogram[d];
+	}
+	for (size_t d = 0u; d < write_histogram.size(); d++) {
+		accesses += write_histogram[d];
+	}
+	if (accesses == 0u) {
+		return 0.0;
+	}
+	uint64_t hits = read_hits(associativity) + write_hits(associativity);
+	return static_cast<double>(accesses - hits) / static_cast<double>(accesses);
+}
+
+// ReuseAnalyzer
+
+ReuseAnalyzer::ReuseAnalyzer(const std::vector<Access> &trace, bool write_allocate)
+	: _write_allocate(write_allocate) {
+	_trace.reserve(trace.size());
+	for (size_t i = 0u; i < trace.size(); i++) {
+		if (trace[i].kind != Access::WRITE || _write_allocate) { // write-no-allocate writes never touch the cache
+			_trace.push_back(trace[i]);
+		}
+	}
+}
+
+static void _check_geometry(uint32_t block_size, uint32_t set_count) {
+	if (block_size < 4_Bytes || block_size > 512_Bytes) {
+		throw std::invalid_argument("Block size must be between 4 Bytes and 512 Bytes.");
+	}
+	if (set_count < 1u || set_count > 256u || (set_count & (set_count - 1)) != 0) {
+		throw std::invalid_argument("Set count must be a power of 2 between 1 and 256.");
+	}
+}
+
+ReuseProfile ReuseAnalyzer::profile(uint32_t block_size, uint32_t set_count) const {
+	return profiles(block_size, std::vector<uint32_t>(1, set_count))[0];
+}
+
+std::vector<ReuseProfile> ReuseAnalyzer::profiles(uint32_t block_size, const std::vector<uint32_t> &set_counts) const {
+	for (size_t s = 0u; s < set_counts.size(); s++) {
+		_check_geometry(block_size, set_counts[s]);
+	}
+	std::vector<uint32_t> blocks, ids;
+	uint32_t id_count = _block_ids(block_size, blocks, ids);
+	std::vector<ReuseProfile> result;
+	result.reserve(set_counts.size());
+	for (size_t s = 0u; s < set_counts.size(); s++) {
+		result.push_back(_profile(block_size, set_counts[s], blocks, ids, id_count));
+	}
+	return result;
+}
+
+uint32_t ReuseAnalyzer::_block_ids(uint32_t block_size, std::vector<uint32_t> &blocks, std::vector<uint32_t> &ids) const {
+	const size_t n = _trace.size();
+	blocks.assign(n, 0u);
+	ids.assign(n, 0u);
+
+	// sort (block, index) pairs once; a block number identifies both set and tag
+	std::vector<uint64_t> order;
+	order.reserve(n);
+	for (size_t i = 0u; i < n; i++) {
+		if (_trace[i].kind == Access::EMPTY) {
+			continue;
+		}
+		blocks[i] = _trace[i].address / block_size;
+		order.push_back(static_cast<uint64_t>(blocks[i]) << 32 | i);
+	}
+	std::sort(order.begin(), order.end());
+
+	uint32_t id_count = 0u;
+	for (size_t k = 0u; k < order.size(); k++) {
+		if (k > 0u && (order[k] >> 32) != (order[k - 1] >> 32)) {
+			id_count++;
+		}
+		ids[static_cast<uint32_t>(order[k])] = id_count;
+	}
+	return order.empty() ? 0u : id_count + 1u;
+}
+
+ReuseProfile ReuseAnalyzer::_profile(uint32_t block_size, uint32_t set_count, const std::vector<uint32_t> &blocks,
+									 const std::vector<uint32_t> &ids, uint32_t id_count) const {
+	ReuseProfile result;
+	result.block_size = block_size;
+	result.set_count = set_count;
+	result.read_cold = 0u;
+	result.write_cold = 0u;
+	result.set_accesses.assign(set_count, 0u);
+	result.set_blocks.assign(set_count, 0u);
+
+	const size_t n = _trace.size();
+	const uint32_t set_mask = set_count - 1u;
+
+	// where each set's Fenwick tree starts; a tree is indexed by the set's local access time
+	for (size_t i = 0u; i < n; i++) {
+		if (_trace[i].kind != Access::EMPTY) {
+			result.set_accesses[blocks[i] & set_mask]++;
+		}
+	}
+	std::vector<size_t> tree_base(set_count, 0u);
+	for (uint32_t s = 1u; s < set_count; s++) {
+		tree_base[s] = tree_base[s - 1] + result.set_accesses[s - 1];
+	}
+
+	// tree[tree_base[s] + pos - 1] is node pos (1-indexed) of set s's Fenwick tree
+	std::vector<int32_t> tree(n, 0);
+	// last[id] is the 1-indexed local time of the latest access to the block, 0 if none
+	std::vector<uint32_t> last(id_count, 0u);
+	// local time of the latest access in each set
+	std::vector<uint32_t> clock(set_count, 0u);
+	// accesses of a set at local times before epoch[s] happened before the last EMPTY
+	std::vector<uint32_t> epoch(set_count, 1u);
+
+	for (size_t i = 0u; i < n; i++) {
+		if (_trace[i].kind == Access::EMPTY) {
+			// resetting last[] and the trees is equivalent to starting a new epoch:
+			// blocks last touched before it are cold, and their marks lie outside
+			// every range queried afterwards
+			for (uint32_t s = 0u; s < set_count; s++) {
+				epoch[s] = clock[s] + 1u;
+			}
+			continue;
+		}
+		uint32_t set_index = blocks[i] & set_mask;
+		uint32_t id = ids[i];
+		uint32_t prev = last[id];
+		bool write = _trace[i].kind == Access::WRITE;
+		if (prev != 0u && prev == clock[set_index] && prev >= epoch[set_index]) {
+			// the set's most recent block again: distance 0, and leaving the clock and
+			// the block's mark where they are keeps every later distance unchanged
+			std::vector<uint64_t> &histogram = write ? result.write_histogram : result.read_histogram;
+			if (histogram.empty()) {
+				histogram.resize(1, 0u);
+			}
+			histogram[0]++;
+			continue;
+		}
+		int32_t *set_tree = &tree[tree_base[set_index]];
+		uint32_t size = static_cast<uint32_t>(result.set_accesses[set_index]);
+		uint32_t now = ++clock[set_index];
+
+		if (prev == 0u) {
+			result.set_blocks[set_index]++;
+		}
+		if (prev < epoch[set_index]) { // cold miss
+			if (write) {
+				result.write_cold++;
+			} else {
+				result.read_cold++;
+			}
+		} else {
+			// distinct blocks of this set touched strictly between prev and now
+			// prefix(now - 1) - prefix(prev), both walks stopping at their common node
+			int32_t distance = 0;
+			uint32_t upper = now - 1u, lower = prev;
+			while (upper != lower) {
+				if (upper > lower) {
+					distance += set_tree[upper - 1u];
+					upper -= upper & (~upper + 1u);
+				} else {
+					distance -= set_tree[lower - 1u];
+					lower -= lower & (~lower + 1u);
+				}
+			}
+			std::vector<uint64_t> &histogram = write ? result.write_histogram : result.read_histogram;
+			if (histogram.size() <= static_cast<size_t>(distance)) {
+				histogram.resize(std::max<size_t>(distance + 1, histogram.size() * 2), 0u);
+			}
+			histogram[distance]++;
+		}
+		if (prev != 0u) {
+			for (uint32_t pos = prev; pos <= size; pos += pos & (~pos + 1u)) {
+				set_tree[pos - 1u]--;
+			}
+		}
+		for (uint32_t pos = now; pos <= size; pos += pos & (~pos + 1u)) {
+			set_tree[pos - 1u]++;
+		}
+		last[id] = now;
+	}
+	// drop the zero tail left by geometric growth
+	while (!result.read_histogram.empty() && result.read_histogram.back() == 0u) {
+		result.read_histogram.pop_back();
+	}
+	while (!result.write_histogram.empty() && result.write_histogram.back() == 0u) {
+		result.write_histogram.pop_back();
+	}
+	return result;
+}
+
+// trace parsing
+
+static uint32_t _parse_number(const std::string &token, size_t line_number) {
+	char *end = nullptr;
+	unsigned long value = std::strtoul(token.c_str(), &end, 0);
+	if (token.empty() || *end != '\0' || value > 0xFFFFFFFFul) {
+		throw std::invalid_argument("Trace line " + std::to_string(line_number) + ": bad number '" + token + "'.");
+	}
+	return static_cast<uint32_t>(value);
+}
+
+std::vector<Access> parse_trace(const std::string &text) {
+	std::vector<Access> trace;
+	std::istringstream input(text);
+	std::string line;
+	size_t line_number = 0u;
+	while (std::getline(input, line)) {
+		line_number++;
+		size_t comment = line.find('#');
+		if (comment != std::string::npos) {
+			line.erase(comment);
+		}
+		std::istringstream fields(line);
+		std::string op, first, second, extra;
+		if (!(fields >> op)) {
+			continue; // blank line
+		}
+		fields >> first >> second >> extra;
+		if (!extra.empty()) {
+			throw std::invalid_argument("Trace line " + std::to_string(line_number) + ": too many fields.");
+		}
+		if (op == "R" || op == "W") {
+			if (first.empty() || !second.empty()) {
+				throw std::invalid_argument("Trace line " + std::to_string(line_number) + ": expected '" + op + " <addr>'.");
+			}
+			Access access;
+			access.kind = op == "W" ? Access::WRITE : Access::READ;
+			access.address = _parse_number(first, line_number);
+			trace.push_back(access);
+		} else if (op == "R1024" || op == "W1024") {
+			if (second.empty()) {
+				throw std::invalid_argument("Trace line " + std::to_string(line_number) + ": expected '" + op + " <base> <stride>'.");
+			}
+			append_1024(trace, _parse_number(first, line_number), _parse_number(second, line_number), op == "W1024");
+		} else if (op == "E") {
+			if (!first.empty()) {
+				throw std::invalid_argument("Trace line " + std::to_string(line_number) + ": expected 'E'.");
+			}
+			Access access;
+			access.kind = Access::EMPTY;
+			access.address = 0u;
+			trace.push_back(access);
+		} else {
+			throw std::invalid_argument("Trace line " + std::to_string(line_number) + ": unknown operation '" + op + "'.");
+		}
+	}
+	return trace;
+}
+
+} // namespace CACHE
@@ -0,0 +1,111 @@
+#ifndef ANALYZER_H
+#define ANALYZER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CACHE{
+
+/// @brief A single operation in a trace fed to the cache
+struct Access {
+	/// READ / WRITE touch one address; EMPTY resets the cache like Cache::empty()
+	enum Kind { READ, WRITE, EMPTY } kind;
+	uint32_t address;
+};
+
+/// @brief Append the 1024 addresses touched by read_1024 / write_1024 to a trace
+/// @param trace trace to append to
+/// @param base_addr starting address
+/// @param stride difference between consecutive addresses
+/// @param write whether the accesses are writes
+void append_1024(std::vector<Access> &trace, uint32_t base_addr, uint32_t stride, bool write);
+
+/// @brief Per-set LRU stack distance profile of a trace for one block size and set count.
+/// An access with stack distance d hits in an LRU cache of associativity A iff d < A,
+/// so a single profile predicts the hit counts of every associativity at once.
+struct ReuseProfile {
+	uint32_t block_size;
+	uint32_t set_count;
+	/// read_histogram[d]: number of reads with per-set stack distance d
+	std::vector<uint64_t> read_histogram;
+	/// write_histogram[d]: number of allocating writes with per-set stack distance d
+	std::vector<uint64_t> write_histogram;
+	/// number of reads touching a block for the first time since the last EMPTY
+	uint64_t read_cold;
+	/// number of allocating writes touching a block for the first time since the last EMPTY
+	uint64_t write_cold;
+	/// number of accesses mapped to each set
+	std::vector<uint64_t> set_accesses;
+	/// number of distinct blocks mapped to each set
+	std::vector<uint64_t> set_blocks;
+
+	/// @brief Predicted number of read hits for a given associativity under LRU
+	/// @param associativity
+	/// @return number of reads with stack distance below associativity
+	uint64_t read_hits(uint32_t associativity) const;
+	/// @brief Predicted number of write hits for a given associativity under LRU
+	/// @param associativity
+	/// @return number of allocating writes with stack distance below associativity
+	uint64_t write_hits(uint32_t associativity) const;
+	/// @brief Predicted miss ratio over all cache-touching accesses
+	/// @param associativity
+	/// @return misses / accesses, or 0 for an empty trace
+	double miss_ratio(uint32_t associativity) const;
+};
+
+/// @brief Reuse-distance analyzer over an access trace.
+/// Each profile is computed in O(N log N) with one Fenwick tree per set, indexed by
+/// the set's local access time, holding a mark at the latest access of every block.
+/// Predictions hold for the LRU policy; LFU is not a stack algorithm and must be simulated.
+class ReuseAnalyzer {
+private:
+	std::vector<Access> _trace;
+	bool _write_allocate;
+
+	/// @brief Map every access to a dense block id; depends only on the block size
+	/// @param block_size
+	/// @param blocks filled with the block number of every access
+	/// @param ids filled with the dense id of every access's block
+	/// @return number of distinct blocks
+	uint32_t _block_ids(uint32_t block_size, std::vector<uint32_t> &blocks, std::vector<uint32_t> &ids) const;
+	/// @brief Compute one profile from precomputed block ids
+	/// @param block_size
+	/// @param set_count
+	/// @param blocks block number of every access
+	/// @param ids dense block id of every access
+	/// @param id_count number of distinct blocks
+	/// @return profile of the trace under the given geometry
+	ReuseProfile _profile(uint32_t block_size, uint32_t set_count, const std::vector<uint32_t> &blocks,
+						  const std::vector<uint32_t> &ids, uint32_t id_count) const;
+
+public:
+	/// @brief Construct an analyzer over a trace
+	/// @param trace accesses in program order
+	/// @param write_allocate whether writes load the block; write-no-allocate
+	///        writes leave the cache untouched and are ignored
+	ReuseAnalyzer(const std::vector<Access> &trace, bool write_allocate);
+
+	/// @brief Compute the stack distance profile for one block size and set count
+	/// @param block_size Block size in bytes, any value in [4, 512]
+	/// @param set_count Number of sets, a power of 2 between 1 and 256
+	/// @return profile of the trace under the given geometry
+	ReuseProfile profile(uint32_t block_size, uint32_t set_count) const;
+	/// @brief Compute the profiles of several set counts sharing one block size,
+	/// mapping blocks to dense ids only once
+	/// @param block_size Block size in bytes, any value in [4, 512]
+	/// @param set_counts Numbers of sets, each a power of 2 between 1 and 256
+	/// @return one profile per set count, in the order given
+	std::vector<ReuseProfile> profiles(uint32_t block_size, const std::vector<uint32_t> &set_counts) const;
+};
+
+/// @brief Parse a trace. Each line is one of
+///   R <addr> | W <addr> | R1024 <base> <stride> | W1024 <base> <stride> | E
+/// with numbers in decimal or 0x-prefixed hex; blank lines and '#' comments are skipped.
+/// @param text trace contents
+/// @return parsed accesses; throws std::invalid_argument on malformed lines
+std::vector<Access> parse_trace(const std::string &text);
+
+} // namespace CACHE
+
+#endif // ANALYZER_H
@@ -0,0 +1,427 @@
+#include "analyzer.h"
+#include "cache.h"
+#include "reference_cache.h"
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace CACHE{
+
+/// @brief Single-access entry points into both engines, and views of their state
+struct EngineProbe {
+	static uint32_t read(Cache &cache, uint32_t address) { return cache._read(address); }
+	static uint32_t write(Cache &cache, uint32_t address) { return cache._write(address); }
+	static uint32_t read(ReferenceCache &cache, uint32_t address) { return cache._read(address); }
+	static uint32_t write(ReferenceCache &cache, uint32_t address) { return cache._write(address); }
+
+	/// @brief Describe one cache line; an engine with a different layout maps its state here
+	template <typename Engine>
+	static std::string line(const Engine &engine, uint32_t set_index, uint32_t way) {
+		return "valid=" + std::to_string(engine.valid[set_index][way]) +
+			   " dirty=" + std::to_string(engine.dirty[set_index][way]) +
+			   " tag=" + std::to_string(engine.tag[set_index][way]) +
+			   " cnt=" + std::to_string(engine.cnt[set_index][way]);
+	}
+	/// @brief Compare one cache line of two engines field by field
+	template <typename Expected, typename Actual>
+	static bool same_line(const Expected &expected, const Actual &actual, uint32_t set_index, uint32_t way) {
+		return expected.valid[set_index][way] == actual.valid[set_index][way] &&
+			   expected.dirty[set_index][way] == actual.dirty[set_index][way] &&
+			   expected.tag[set_index][way] == actual.tag[set_index][way] &&
+			   expected.cnt[set_index][way] == actual.cnt[set_index][way];
+	}
+	/// @brief Describe the read_1024 / write_1024 limit counters
+	template <typename Engine>
+	static std::string counters(const Engine &engine) {
+		return "read_count=" + std::to_string(engine._read_count) + " write_count=" + std::to_string(engine._write_count);
+	}
+};
+
+} // namespace CACHE
+
+using namespace CACHE;
+
+/// @brief Cache geometry and policies of one fuzz case
+struct Config {
+	uint32_t block_size;
+	uint32_t associativity;
+	uint32_t set_count;
+	std::string replacement_policy;
+	bool write_back;
+	bool write_allocate;
+	uint32_t read_limit;
+	uint32_t write_limit;
+};
+
+/// @brief One operation of a fuzz stream
+struct Op {
+	enum Kind { READ, WRITE, READ_1024, WRITE_1024, EMPTY } kind;
+	uint32_t address; // base address for READ_1024 / WRITE_1024
+	uint32_t stride;
+};
+
+/// @brief Mismatch::index of a divergence while constructing the engines
+static const size_t construction = static_cast<size_t>(-1);
+
+/// @brief Results of both sides at the first divergence
+struct Mismatch {
+	size_t index; // op index, or construction
+	std::string expected;
+	std::string actual;
+};
+
+/// @brief Check a stream; fills mismatch and returns true on failure
+typedef bool (*Check)(const Config &config, const std::vector<Op> &ops, Mismatch &mismatch);
+
+static const uint32_t associativities[] = {1u, 2u, 4u, 8u, 16u};
+
+static void print_config(const Config &config) {
+	std::printf("config: block_size=%u associativity=%u set_count=%u policy=%s write_back=%d write_allocate=%d"
+				" read_limit=%u write_limit=%u\n",
+				config.block_size, config.associativity, config.set_count, config.replacement_policy.c_str(),
+				config.write_back, config.write_allocate, config.read_limit, config.write_limit);
+}
+
+static void print_op(const Op &op) {
+	switch (op.kind) {
+	case Op::READ: std::printf("R 0x%08x", op.address); break;
+	case Op::WRITE: std::printf("W 0x%08x", op.address); break;
+	case Op::READ_1024: std::printf("R1024 0x%08x 0x%08x", op.address, op.stride); break;
+	case Op::WRITE_1024: std::printf("W1024 0x%08x 0x%08x", op.address, op.stride); break;
+	case Op::EMPTY: std::printf("E"); break;
+	}
+}
+
+/// @brief Describe the exception being handled; called from a catch block
+/// @return "threw <type>: <what>", so both the type and the message are diffed
+static std::string thrown() {
+	try {
+		throw;
+	} catch (const std::exception &e) {
+		return std::string("threw ") + typeid(e).name() + ": " + e.what();
+	} catch (...) {
+		return "threw a non-std exception";
+	}
+}
+
+/// @brief Construct an engine from a possibly invalid config
+/// @return "ok", or the exception thrown by the constructor
+template <typename Engine>
+static std::string construct(std::unique_ptr<Engine> &engine, const Config &config) {
+	try {
+		engine.reset(new Engine(config.block_size, config.associativity, config.set_count, config.replacement_policy,
+								config.write_back, config.write_allocate, config.read_limit, config.write_limit));
+		return "ok";
+	} catch (...) {
+		return thrown();
+	}
+}
+
+/// @brief Apply one op to an engine
+/// @return hit flag for reads, latency for writes, 0 for EMPTY, or the exception thrown
+template <typename Engine>
+static std::string apply(Engine &engine, const Op &op) {
+	try {
+		switch (op.kind) {
+		case Op::READ: return std::to_string(EngineProbe::read(engine, op.address));
+		case Op::WRITE: return std::to_string(EngineProbe::write(engine, op.address));
+		case Op::READ_1024: return std::to_string(engine.read_1024(op.address, op.stride));
+		case Op::WRITE_1024: return std::to_string(engine.write_1024(op.address, op.stride));
+		case Op::EMPTY: engine.empty(); return "0";
+		}
+	} catch (...) {
+		return thrown();
+	}
+	return "0";
+}
+
+/// @brief Diff the full state of both engines: limit counters and every cache line
+/// @param reference
+/// @param cache
+/// @param config
+/// @param mismatch filled with the first differing counter or line
+/// @return true if the states differ
+static bool state_differs(const ReferenceCache &reference, const Cache &cache, const Config &config,
+						  Mismatch &mismatch) {
+	mismatch.expected = EngineProbe::counters(reference);
+	mismatch.actual = EngineProbe::counters(cache);
+	if (mismatch.expected != mismatch.actual) {
+		return true;
+	}
+	for (uint32_t set_index = 0u; set_index < config.set_count; set_index++) {
+		for (uint32_t way = 0u; way < config.associativity; way++) {
+			if (!EngineProbe::same_line(reference, cache, set_index, way)) {
+				std::string where = "set " + std::to_string(set_index) + " way " + std::to_string(way) + ": ";
+				mismatch.expected = where + EngineProbe::line(reference, set_index, way);
+				mismatch.actual = where + EngineProbe::line(cache, set_index, way);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/// @brief Drive a stream through both engines in lockstep. After every READ_1024,
+/// WRITE_1024 and EMPTY the full engine state is diffed as well, so a batch whose
+/// per-access differences cancel out in the returned sum is caught at that op.
+/// @param config
+/// @param ops
+/// @param mismatch filled with the first divergence, if any
+/// @return true if the engines diverge
+static bool diverges(const Config &config, const std::vector<Op> &ops, Mismatch &mismatch) {
+	std::unique_ptr<ReferenceCache> reference;
+	std::unique_ptr<Cache> cache;
+	mismatch.index = construction;
+	mismatch.expected = construct(reference, config);
+	mismatch.actual = construct(cache, config);
+	if (mismatch.expected != mismatch.actual) {
+		return true;
+	}
+	if (!reference) { // both rejected the config the same way
+		return false;
+	}
+
+	for (size_t i = 0u; i < ops.size(); i++) {
+		const Op &op = ops[i];
+		mismatch.index = i;
+		mismatch.expected = apply(*reference, op);
+		mismatch.actual = apply(*cache, op);
+		if (mismatch.expected != mismatch.actual) {
+			return true;
+		}
+		if (op.kind != Op::READ && op.kind != Op::WRITE && state_differs(*reference, *cache, config, mismatch)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/// @brief Replay a stream through Cache one access at a time and compare its LRU
+/// hit counts with the reuse-distance analyzer's prediction
+/// @param config LRU config
+/// @param ops
+/// @param mismatch filled with predicted and simulated read / write hits on failure
+/// @return true if the prediction is wrong
+static bool mispredicts(const Config &config, const std::vector<Op> &ops, Mismatch &mismatch) {
+	Cache cache(config.block_size, config.associativity, config.set_count, config.replacement_policy,
+				config.write_back, config.write_allocate, config.read_limit, config.write_limit);
+	std::vector<Access> trace;
+	uint64_t read_hits = 0u, write_hits = 0u;
+	for (size_t i = 0u; i < ops.size(); i++) {
+		const Op &op = ops[i];
+		if (op.kind == Op::EMPTY) {
+			cache.empty();
+			Access access;
+			access.kind = Access::EMPTY;
+			access.address = 0u;
+			trace.push_back(access);
+			continue;
+		}
+		bool write = op.kind == Op::WRITE || op.kind == Op::WRITE_1024;
+		size_t first = trace.size();
+		if (op.kind == Op::READ_1024 || op.kind == Op::WRITE_1024) {
+			append_1024(trace, op.address, op.stride, write);
+		} else {
+			Access access;
+			access.kind = write ? Access::WRITE : Access::READ;
+			access.address = op.address;
+			trace.push_back(access);
+		}
+		for (size_t k = first; k < trace.size(); k++) {
+			if (!write) {
+				read_hits += EngineProbe::read(cache, trace[k].address);
+			} else if (EngineProbe::write(cache, trace[k].address) != 100u && config.write_allocate) {
+				write_hits++; // allocating writes miss at miss_latency and hit below it
+			}
+		}
+	}
+	ReuseProfile profile = ReuseAnalyzer(trace, config.write_allocate).profile(config.block_size, config.set_count);
+	uint64_t predicted_reads = profile.read_hits(config.associativity);
+	uint64_t predicted_writes = profile.write_hits(config.associativity);
+	if (predicted_reads == read_hits && predicted_writes == write_hits) {
+		return false;
+	}
+	mismatch.index = ops.size() - 1u;
+	mismatch.expected = std::to_string(predicted_reads) + " read / " + std::to_string(predicted_writes) + " write hits";
+	mismatch.actual = std::to_string(read_hits) + " read / " + std::to_string(write_hits) + " write hits";
+	return true;
+}
+
+/// @brief Shrink a failing stream: truncate after the failing op, then remove
+/// ever smaller chunks of ops while the check still fails
+/// @param config
+/// @param ops failing stream, minimized in place
+/// @param check
+static void minimize(const Config &config, std::vector<Op> &ops, Check check) {
+	Mismatch mismatch;
+	check(config, ops, mismatch);
+	ops.resize(mismatch.index + 1);
+	for (size_t chunk = ops.size() / 2; chunk > 0u; chunk /= 2) {
+		for (size_t start = 0u; start + chunk <= ops.size();) {
+			std::vector<Op> candidate(ops.begin(), ops.begin() + start);
+			candidate.insert(candidate.end(), ops.begin() + start + chunk, ops.end());
+			if (!candidate.empty() && check(config, candidate, mismatch)) {
+				candidate.resize(mismatch.index + 1);
+				ops.swap(candidate);
+			} else {
+				start += chunk;
+			}
+		}
+	}
+}
+
+/// @brief Random config within the global bounds; with invalid set, one in eight
+/// configs instead draws every parameter from a wider, possibly invalid range
+static Config random_config(std::mt19937 &rng, bool invalid) {
+	static const char *const policies[] = {"LRU", "LFU", "FIFO", "lru", ""};
+	Config config;
+	// small limits make read_1024 / write_1024 hit their limit checks
+	config.read_limit = rng() % 2u ? rng() % 8u : 0xFFFFFFFFu;
+	config.write_limit = rng() % 2u ? rng() % 8u : 0xFFFFFFFFu;
+	if (invalid && rng() % 8u == 0u) {
+		config.block_size = rng() % 600u;
+		config.associativity = rng() % 20u;
+		config.set_count = rng() % 300u;
+		config.replacement_policy = policies[rng() % 5u];
+		config.write_back = rng() % 2u;
+		config.write_allocate = rng() % 2u;
+		return config;
+	}
+	config.block_size = 4u + rng() % 509u;
+	config.associativity = associativities[rng() % 5u];
+	config.set_count = 1u << (rng() % 9u);
+	config.replacement_policy = rng() % 2u ? "LRU" : "LFU";
+	switch (rng() % 3u) { // (1) WB & WA, (2) WT & WA, (3) WT & WNA
+	case 0u: config.write_back = true; config.write_allocate = true; break;
+	case 1u: config.write_back = false; config.write_allocate = true; break;
+	default: config.write_back = false; config.write_allocate = false; break;
+	}
+	return config;
+}
+
+/// @brief Random stream biased towards a few hot sets so that evictions and ties are frequent
+static std::vector<Op> random_ops(std::mt19937 &rng, const Config &config, size_t length) {
+	// invalid configs may have zero sizes; their streams only matter if an engine accepts them
+	uint32_t block_size = config.block_size ? config.block_size : 1u;
+	uint32_t set_count = config.set_count ? config.set_count : 1u;
+	uint32_t tags = config.associativity + 1u + rng() % (2u * config.associativity + 2u);
+	uint32_t sets = set_count < 4u ? set_count : 1u + rng() % 4u;
+	std::vector<Op> ops(length);
+	for (size_t i = 0u; i < length; i++) {
+		Op &op = ops[i];
+		uint32_t kind = rng() % 100u;
+		op.kind = kind < 60u ? Op::READ : kind < 95u ? Op::WRITE : kind < 98u ? (rng() % 2u ? Op::READ_1024 : Op::WRITE_1024) : Op::EMPTY;
+		if (rng() % 16u == 0u) {
+			op.address = static_cast<uint32_t>(rng()); // anywhere, including tag wrap-around
+		} else {
+			op.address = ((rng() % tags) * set_count + rng() % sets) * block_size + rng() % block_size;
+		}
+		switch (rng() % 3u) {
+		case 0u: op.stride = rng() % 8u; break;
+		case 1u: op.stride = block_size * set_count * (rng() % 4u); break;
+		default: op.stride = 1u << (rng() % 32u); break;
+		}
+	}
+	return ops;
+}
+
+static void usage(const char *program) {
+	std::fprintf(stderr,
+				 "usage: %s [-a] [-n cases] [-l length] [-s seed]\n"
+				 "  -a         check reuse-distance analyzer predictions against Cache (LRU)\n"
+				 "             instead of diffing Cache against ReferenceCache\n"
+				 "  -n cases   number of random configs to run, at least 1 (default 2000)\n"
+				 "  -l length  maximum ops per stream, 1 to 1000000 (default 2000)\n"
+				 "  -s seed    random seed (default 1)\n",
+				 program);
+}
+
+/// @brief Parse a number in [low, high], decimal or 0x-prefixed hex
+/// @param text
+/// @param what name of the option for error messages
+/// @return parsed value; throws std::invalid_argument if malformed or out of range
+static uint32_t parse_number(const std::string &text, const char *what, uint32_t low, uint32_t high) {
+	char *end = nullptr;
+	unsigned long value = std::strtoul(text.c_str(), &end, 0);
+	if (text.empty() || *end != '\0' || text[0] == '-' || value < low || value > high) {
+		throw std::invalid_argument(std::string(what) + " '" + text + "' must be between " + std::to_string(low) +
+									" and " + std::to_string(high) + ".");
+	}
+	return static_cast<uint32_t>(value);
+}
+
+int main(int argc, char **argv) {
+	uint64_t cases = 2000u;
+	size_t length = 2000u;
+	uint32_t seed = 1u;
+	bool analyzer = false;
+	try {
+		for (int i = 1; i < argc; i++) {
+			std::string arg = argv[i];
+			if (arg == "-a") {
+				analyzer = true;
+			} else if (arg == "-n" && i + 1 < argc) {
+				cases = parse_number(argv[++i], "Case count", 1u, 0xFFFFFFFFu);
+			} else if (arg == "-l" && i + 1 < argc) {
+				length = parse_number(argv[++i], "Stream length", 1u, 1000000u);
+			} else if (arg == "-s" && i + 1 < argc) {
+				seed = parse_number(argv[++i], "Seed", 0u, 0xFFFFFFFFu);
+			} else {
+				usage(argv[0]);
+				return 1;
+			}
+		}
+	} catch (const std::exception &e) {
+		std::fprintf(stderr, "%s\n", e.what());
+		usage(argv[0]);
+		return 1;
+	}
+
+	Check check = analyzer ? mispredicts : diverges;
+	std::mt19937 rng(seed);
+	uint64_t total_ops = 0u;
+	for (uint64_t n = 0u; n < cases; n++) {
+		Config config = random_config(rng, !analyzer);
+		if (analyzer) {
+			config.replacement_policy = "LRU"; // LFU is not a stack algorithm
+		}
+		std::vector<Op> ops = random_ops(rng, config, 1u + rng() % length);
+		total_ops += ops.size();
+
+		Mismatch mismatch;
+		if (!check(config, ops, mismatch)) {
+			continue;
+		}
+		std::printf("case %llu (seed %u): %s ", (unsigned long long)n, seed,
+					analyzer ? "analyzer mispredicts Cache" : "engines diverge");
+		if (mismatch.index == construction) {
+			std::printf("at construction\n");
+		} else {
+			std::printf("at op %zu of %zu\n", mismatch.index, ops.size());
+		}
+		minimize(config, ops, check);
+		check(config, ops, mismatch);
+		print_config(config);
+		std::printf("minimized stream (%zu ops):\n", ops.size());
+		for (size_t i = 0u; i < ops.size(); i++) {
+			std::printf("  ");
+			print_op(ops[i]);
+			std::printf("\n");
+		}
+		if (mismatch.index == construction) {
+			std::printf("construction:");
+		} else {
+			std::printf("last op:");
+		}
+		std::printf(" %s %s, %s %s\n", analyzer ? "analyzer predicted" : "reference", mismatch.expected.c_str(),
+					analyzer ? "Cache counted" : "engine", mismatch.actual.c_str());
+		return 1;
+	}
+	std::printf("%llu cases, %llu ops: no divergence\n", (unsigned long long)cases, (unsigned long long)total_ops);
+	return 0;
+}
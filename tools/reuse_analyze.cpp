@@ -0,0 +1,195 @@
+#include "analyzer.h"
+#include "cache.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace CACHE;
+
+static const uint32_t associativities[] = {1u, 2u, 4u, 8u, 16u};
+static const uint32_t set_counts[] = {1u, 2u, 4u, 8u, 16u, 32u, 64u, 128u, 256u};
+
+static void usage(const char *program) {
+	std::fprintf(stderr,
+				 "usage: %s [-b sizes] [-p set_count] [-n] [trace]\n"
+				 "  -b sizes      block sizes, e.g. 64 or 4,8,16 or 4-512 (default: powers of 2 in [4, 512]);\n"
+				 "                each size costs about 0.5 s per 1M accesses, so sweeping all 509 sizes\n"
+				 "                with 4-512 takes minutes\n"
+				 "  -p set_count  also print the per-set pressure for this set count\n"
+				 "  -n            write-no-allocate (writes bypass the cache)\n"
+				 "  trace         trace file, stdin if omitted; lines are\n"
+				 "                R <addr> | W <addr> | R1024 <base> <stride> | W1024 <base> <stride> | E\n",
+				 program);
+}
+
+/// @brief Parse a number in [low, high], decimal or 0x-prefixed hex
+/// @param text
+/// @param what name of the option for error messages
+/// @return parsed value; throws std::invalid_argument if malformed or out of range
+static uint32_t parse_number(const std::string &text, const char *what, uint32_t low, uint32_t high) {
+	char *end = nullptr;
+	unsigned long value = std::strtoul(text.c_str(), &end, 0);
+	if (text.empty() || *end != '\0' || text[0] == '-' || value < low || value > high) {
+		throw std::invalid_argument(std::string(what) + " '" + text + "' must be between " + std::to_string(low) +
+									" and " + std::to_string(high) + ".");
+	}
+	return static_cast<uint32_t>(value);
+}
+
+/// @brief Parse a block size list such as "64", "4,8,16" or "4-512"
+/// @param text
+/// @return block sizes in the order given; throws std::invalid_argument on
+///         malformed items, reversed ranges or sizes outside [4, 512]
+static std::vector<uint32_t> parse_block_sizes(const std::string &text) {
+	std::vector<uint32_t> sizes;
+	std::istringstream items(text);
+	std::string item;
+	while (std::getline(items, item, ',')) {
+		size_t dash = item.find('-', 1);
+		uint32_t low = parse_number(item.substr(0, dash), "Block size", 4_Bytes, 512_Bytes);
+		uint32_t high = dash == std::string::npos ? low : parse_number(item.substr(dash + 1), "Block size", 4_Bytes, 512_Bytes);
+		if (low > high) {
+			throw std::invalid_argument("Block size range '" + item + "' is reversed.");
+		}
+		for (uint32_t size = low; size <= high; size++) {
+			sizes.push_back(size);
+		}
+	}
+	if (sizes.empty()) {
+		throw std::invalid_argument("No block sizes given.");
+	}
+	return sizes;
+}
+
+static void print_profile_summary(const ReuseProfile &full) {
+	// reuse distance histogram in power-of-2 buckets
+	std::vector<uint64_t> buckets;
+	for (size_t d = 0u; d < full.read_histogram.size() || d < full.write_histogram.size(); d++) {
+		uint64_t count = (d < full.read_histogram.size() ? full.read_histogram[d] : 0u) +
+						 (d < full.write_histogram.size() ? full.write_histogram[d] : 0u);
+		size_t bucket = 0u;
+		while ((static_cast<size_t>(1u) << bucket) <= d) {
+			bucket++;
+		}
+		if (buckets.size() <= bucket) {
+			buckets.resize(bucket + 1, 0u);
+		}
+		buckets[bucket] += count;
+	}
+	std::printf("reuse distance histogram (distinct blocks between reuses):\n");
+	for (size_t bucket = 0u; bucket < buckets.size(); bucket++) {
+		uint64_t low = bucket == 0u ? 0u : (1ull << (bucket - 1));
+		uint64_t high = 1ull << bucket;
+		std::printf("  [%8llu, %8llu) %12llu\n", (unsigned long long)low, (unsigned long long)high,
+					(unsigned long long)buckets[bucket]);
+	}
+	std::printf("  cold               %12llu\n", (unsigned long long)(full.read_cold + full.write_cold));
+
+	// miss ratio curve of a fully associative LRU cache
+	std::printf("miss ratio curve (fully associative, capacity in blocks):\n");
+	for (uint32_t capacity = 1u; capacity <= 4096u; capacity <<= 1) {
+		std::printf("  %6u blocks %9u Bytes  %.6f\n", capacity, capacity * full.block_size, full.miss_ratio(capacity));
+	}
+}
+
+int main(int argc, char **argv) {
+	std::vector<uint32_t> block_sizes;
+	for (uint32_t size = 4_Bytes; size <= 512_Bytes; size <<= 1) {
+		block_sizes.push_back(size);
+	}
+	uint32_t pressure_sets = 0u;
+	bool write_allocate = true;
+	const char *trace_path = nullptr;
+
+	try {
+		for (int i = 1; i < argc; i++) {
+			std::string arg = argv[i];
+			if (arg == "-b" && i + 1 < argc) {
+				block_sizes = parse_block_sizes(argv[++i]);
+			} else if (arg == "-p" && i + 1 < argc) {
+				pressure_sets = parse_number(argv[++i], "Set count", 1u, 256u);
+				if ((pressure_sets & (pressure_sets - 1)) != 0) {
+					throw std::invalid_argument("Set count must be a power of 2 between 1 and 256.");
+				}
+			} else if (arg == "-n") {
+				write_allocate = false;
+			} else if (arg[0] != '-' && trace_path == nullptr) {
+				trace_path = argv[i];
+			} else {
+				usage(argv[0]);
+				return 1;
+			}
+		}
+	} catch (const std::exception &e) {
+		std::fprintf(stderr, "%s\n", e.what());
+		usage(argv[0]);
+		return 1;
+	}
+
+	std::stringstream text;
+	if (trace_path == nullptr) {
+		text << std::cin.rdbuf();
+	} else {
+		std::ifstream file(trace_path);
+		if (!file) {
+			std::fprintf(stderr, "cannot open %s\n", trace_path);
+			return 1;
+		}
+		text << file.rdbuf();
+	}
+
+	try {
+		std::vector<Access> trace = parse_trace(text.str());
+		ReuseAnalyzer analyzer(trace, write_allocate);
+		std::printf("trace: %zu accesses, %s\n", trace.size(), write_allocate ? "write-allocate" : "write-no-allocate");
+		std::vector<uint32_t> geometry_sets(set_counts, set_counts + sizeof(set_counts) / sizeof(set_counts[0]));
+
+		for (size_t b = 0u; b < block_sizes.size(); b++) {
+			uint32_t block_size = block_sizes[b];
+			std::vector<ReuseProfile> profiles = analyzer.profiles(block_size, geometry_sets);
+			std::printf("\n== block size %u Bytes ==\n", block_size);
+			print_profile_summary(profiles[0]);
+
+			std::printf("predicted LRU hits (reads / writes) and max blocks per set:\n");
+			std::printf("  %5s", "sets");
+			for (size_t a = 0u; a < sizeof(associativities) / sizeof(associativities[0]); a++) {
+				std::printf("  %15s%-6u", "assoc ", associativities[a]);
+			}
+			std::printf("  %10s\n", "pressure");
+			for (size_t s = 0u; s < sizeof(set_counts) / sizeof(set_counts[0]); s++) {
+				const ReuseProfile &profile = profiles[s];
+				std::printf("  %5u", set_counts[s]);
+				for (size_t a = 0u; a < sizeof(associativities) / sizeof(associativities[0]); a++) {
+					std::printf("  %10llu/%10llu", (unsigned long long)profile.read_hits(associativities[a]),
+								(unsigned long long)profile.write_hits(associativities[a]));
+				}
+				uint64_t pressure = 0u;
+				for (uint32_t i = 0u; i < set_counts[s]; i++) {
+					pressure = profile.set_blocks[i] > pressure ? profile.set_blocks[i] : pressure;
+				}
+				std::printf("  %10llu\n", (unsigned long long)pressure);
+			}
+
+			if (pressure_sets != 0u) {
+				// set counts are powers of 2 from 1, so set_counts[log2(pressure_sets)] is the match
+				size_t s = 0u;
+				while ((1u << s) < pressure_sets) {
+					s++;
+				}
+				const ReuseProfile &profile = profiles[s];
+				std::printf("per-set pressure with %u sets (accesses / distinct blocks):\n", pressure_sets);
+				for (uint32_t i = 0u; i < pressure_sets; i++) {
+					std::printf("  set %3u %12llu %10llu\n", i, (unsigned long long)profile.set_accesses[i],
+								(unsigned long long)profile.set_blocks[i]);
+				}
+			}
+		}
+	} catch (const std::exception &e) {
+		std::fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+	return 0;
+}